@@ -0,0 +1,21 @@
+#include <stdio.h>
+
+#include "trace.h"
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("usage: %s <trace file>\n", argv[0]);
+        return 1;
+    }
+    CParcaeTraceReader reader;
+    if (not reader.Read(argv[1]))
+    {
+        printf("failed to read trace %s\n", argv[1]);
+        return 1;
+    }
+    for (const auto &record : reader.Records())
+        printf("%s\n", reader.Print(record).c_str());
+    return 0;
+}
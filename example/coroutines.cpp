@@ -0,0 +1,41 @@
+#include <stdio.h>
+
+#include "parcae.h"
+
+static CParcae g_parc;
+static int g_i = 0;
+std::string str1;
+std::string str2;
+
+CParcaeTask task_parallel(const std::string thread_name, const int n)
+{
+    std::string &str = (n == 0) ? str1 : str2;
+    co_await g_parc.Milestone(thread_name, 0, true);
+    g_parc.Write(thread_name, &g_i);
+    g_i++;
+    str.append(std::to_string(g_i));
+    co_await g_parc.Milestone(thread_name, 1);
+    g_parc.Write(thread_name, &g_i);
+    g_i++;
+    str.append(std::to_string(g_i));
+    co_await g_parc.Milestone(thread_name, 2);
+}
+
+int main()
+{
+    CParcaeTaskRunner runner(g_parc);
+    runner.Add("A", []() { return task_parallel("A", 0); });
+    runner.Add("B", []() { return task_parallel("B", 1); });
+    g_parc.Start([&runner]()
+    {
+        g_i = 0;
+        str1.clear();
+        str2.clear();
+        runner.Run();
+        printf("%s - %s\n", str1.c_str(), str2.c_str());
+        g_parc.Stop();
+    }, runner.Names());
+    for (const auto &race : g_parc.Races())
+        printf("%s\n", race.Print().c_str());
+    return 0;
+}
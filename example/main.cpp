@@ -11,10 +11,12 @@ void func_parallel(const std::string &thread_name, const int n)
 {
     g_parc->StartThread(thread_name);
     std::string &str = (n == 0) ? str1 : str2;
-    g_parc->Milestone(thread_name, 0);
+    g_parc->Milestone(thread_name, 0, true);
+    g_parc->Write(thread_name, &g_i);
     g_i++;
     str.append(std::to_string(g_i));
     g_parc->Milestone(thread_name, 1);
+    g_parc->Write(thread_name, &g_i);
     g_i++;
     str.append(std::to_string(g_i));
     g_parc->Milestone(thread_name, 2);
@@ -31,13 +33,25 @@ void func()
     t1.join();
     t2.join();
     printf("%s - %s\n", str1.c_str(), str2.c_str());
+    if ((str1 != "12") and (str1 != "34"))
+        g_parc->Fail();
     g_parc->Stop();
 }
 
-int main()
+int main(int argc, char *argv[])
 {
     g_parc = CParcaePtr(new CParcae());
+    if (argc > 1)
+        g_parc->StartTrace(argv[1]);
     g_parc->Start(func, {"B", "A"});
+    if (not g_parc->Failures().empty())
+    {
+        const auto witness = g_parc->Shrink(func, g_parc->Failures().front());
+        printf("MINIMAL FAILURE %s\n", witness.Print().c_str());
+    }
+    for (const auto &race : g_parc->Races())
+        printf("%s\n", race.Print().c_str());
+    g_parc->StopTrace();
     g_parc = nullptr;
     return 0;
 }
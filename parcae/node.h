@@ -5,8 +5,10 @@
 #include <unordered_set>
 #include <cassert>
 #include <vector>
+#include <algorithm>
 
 #include "types.h"
+#include "schedule.h"
 
 class CParcaeNode;
 using CParcaeNodePtr = std::shared_ptr<CParcaeNode>;
@@ -96,7 +98,7 @@ public:
      */
     CParcaeNodePtr FindNext(const std::string thread_name, const uint milestone) const
     {
-        for (const auto p : m_next)
+        for (const auto &p : m_next)
         {
             if ((p->m_thread_name == thread_name) and (p->m_milestone == milestone))
                 return p;
@@ -199,6 +201,28 @@ public:
         str += PrintShort();
         return str;
     }
+    /**
+     * @brief Path - получить расписание, ведущее от корня к этому узлу
+     * @return расписание восходящей цепочки
+     * @remark Шаг отмечается вытеснением, если предыдущий поток ещё был готов к работе
+     */
+    CParcaeSchedule Path() const
+    {
+        std::vector<const CParcaeNode*> nodes;
+        for (const CParcaeNode *node = this; not node->IsRoot(); node = node->m_prev.get())
+            nodes.push_back(node);
+        CParcaeSchedule schedule;
+        const CParcaeNode *prev = nullptr;
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+        {
+            const CParcaeNode *node = *it;
+            const bool preemption = (prev != nullptr) and (prev->m_thread_name != node->m_thread_name) and
+                    (std::find(prev->m_threads_ready.cbegin(), prev->m_threads_ready.cend(), prev->m_thread_name) != prev->m_threads_ready.cend());
+            schedule.AddStep({node->m_thread_name, node->m_milestone, preemption});
+            prev = node;
+        }
+        return schedule;
+    }
     /**
      * @brief PrintTree - получить строковое представление дерева в формате JSON
      * @return строковое представление дерева в формате JSON
@@ -13,8 +13,12 @@
 #include <iostream>
 #include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
 #include "node.h"
+#include "race.h"
+#include "trace.h"
+#include "task.h"
 
 class CParcae
 {
@@ -23,56 +27,35 @@ public:
      * @brief Milestone - наступил новый этап
      * @param[in] thread_name - имя потока
      * @param[in] num - номер этапа
+     * @param[in] local - завершившийся этап не обращался к разделяемым данным
+     * @remark После локального этапа поток продолжает работу без ветвления дерева, так что
+     * подряд идущие локальные этапы сливаются в один шаг. При включённом SetLocalInference
+     * локальным считается и этап без размеченных обращений (Read/Write/Acquire/Release).
+     * @return ожидаемый объект: поток уже продолжил работу, а задача-сопрограмма
+     * (см. CParcaeTaskRunner) должна выполнить co_await, чтобы уступить выбранной задаче
+     * @throw std::logic_error - этап задачи, которая сейчас не выбрана планировщиком
+     * (например, результат предыдущего Milestone не был ожидаем через co_await)
      */
-    void Milestone(const std::string &thread_name, const uint num)
+    CParcaeMilestone Milestone(const std::string &thread_name, const uint num, const bool local = false)
     {
         m_milestone_mutex.lock();
-        PARCAE_LOG("MILESTONE %s:%u # %s\n", thread_name.c_str(), num, m_current_fate->PrintPrevious().c_str());
-        std::string new_thread;
-        if (auto next_this = m_current_fate->FindNext(thread_name, num))
+        if ((m_tasks.count(thread_name) > 0) and (thread_name != m_task_next))
         {
-            PARCAE_LOG("    FOUND\n");
-            std::string next_thread;
-            for (const auto &th_name : m_thread_names)
-            {
-                if (not m_threads.IsReady(th_name))
-                    continue;
-                if (auto next = next_this->FindNext(th_name))
-                    if (next->IsDeadEnd())
-                        continue;
-                next_thread = th_name;
-                break;
-            }
-            if (next_thread.empty())
-                printf("\n\n==== NO THREAD ====\n\n");
-            m_current_fate = next_this;
-            new_thread = next_thread;
+            m_milestone_mutex.unlock();
+            throw std::logic_error("parcae: Milestone of task " + thread_name + " that is not scheduled (missing co_await?)");
         }
-        else
+        const auto new_thread = ChooseMilestoneThread(thread_name, num, local);
+        if (m_tasks.count(thread_name) > 0)
         {
-            PARCAE_LOG("    NOT FOUND\n");
-            for (const auto &th_name : m_thread_names)
-            {
-                if (not m_threads.IsReady(th_name))
-                    continue;
-                if (auto next = m_current_fate->FindNext(th_name))
-                {
-                    if (not next->IsDeadEnd())
-                    {
-                        m_current_fate = next;
-                        break;
-                    }
-                }
-                else
-                {
-                    MakeCurrent(thread_name, num);
-                    break;
-                }
-            }
-            new_thread = m_current_fate->ThreadName();
+            m_task_next = new_thread;
+            m_milestone_mutex.unlock();
+            return CParcaeMilestone(new_thread == thread_name);
         }
+        if (new_thread != thread_name)
+            m_threads.GetThread(thread_name).SetRunning(false);
         m_milestone_mutex.unlock();
         ContinueThread(thread_name, new_thread);
+        return CParcaeMilestone(true);
     }
     /**
      * @brief Start - запуск анализируемых потоков
@@ -86,6 +69,9 @@ public:
         m_root->SetReadyThreads(thread_names);
         m_threads.Clear();
         m_thread_names = thread_names;
+        m_failures.clear();
+        m_races.Clear();
+        m_replay = false;
         while (not m_root->IsDeadEnd())
         {
             NewRound();
@@ -101,16 +87,33 @@ public:
         m_milestone_mutex.lock();
         PARCAE_LOG("START THREAD %s\n", thread_name.c_str());
         m_threads.SetReady(thread_name);
+        m_races.Tick(thread_name);
         if (m_threads.AllReady())
         {
             PARCAE_LOG("    ALL READY continue %s\n", thread_name.c_str());
-            const auto next_th = ChooseNextThread();
+            const auto next_th = m_replay ? ReplayNextThread() : ChooseNextThread();
+            Trace(CParcaeTraceEvent::START, thread_name, 0, next_th);
+            if (m_tasks.count(thread_name) > 0)
+            {
+                m_task_next = next_th;
+                m_milestone_mutex.unlock();
+                return;
+            }
+            if (next_th != thread_name)
+                m_threads.GetThread(thread_name).SetRunning(false);
             m_milestone_mutex.unlock();
             ContinueThread(thread_name, next_th);
         }
         else
         {
             PARCAE_LOG("    NOT ALL READY pause %s\n", thread_name.c_str());
+            Trace(CParcaeTraceEvent::START, thread_name);
+            if (m_tasks.count(thread_name) > 0)
+            {
+                m_milestone_mutex.unlock();
+                return;
+            }
+            m_threads.GetThread(thread_name).SetRunning(false);
             m_milestone_mutex.unlock();
             m_threads.Lock(thread_name);
         }
@@ -123,17 +126,40 @@ public:
     void StopThread(const std::string &thread_name)
     {
         m_milestone_mutex.lock();
+        m_races.Tick(thread_name);
         m_threads.Unlock(thread_name);
         m_threads.SetNotReady(thread_name);
+        if (m_replay)
+        {
+            m_replay_preemption = false;
+            const auto next_th = ReplayNextThread();
+            Trace(CParcaeTraceEvent::STOP, thread_name, 0, next_th);
+            if (m_tasks.count(thread_name) > 0)
+                m_task_next = next_th;
+            else if (not next_th.empty())
+                m_threads.Unlock(next_th);
+            m_milestone_mutex.unlock();
+            return;
+        }
         m_current_fate->SetReadyThreads(m_threads.GetReady());
+        if (m_tasks.count(thread_name) > 0)
+        {
+            m_task_next = FirstReadyThread();
+            Trace(CParcaeTraceEvent::STOP, thread_name, 0, m_task_next);
+            m_milestone_mutex.unlock();
+            return;
+        }
+        std::string next_th;
         for (const auto &th_name : m_thread_names)
         {
             if (not m_threads.GetThread(th_name).IsRunning())
             {
+                next_th = th_name;
                 m_threads.Unlock(th_name);
                 break;
             }
         }
+        Trace(CParcaeTraceEvent::STOP, thread_name, 0, next_th);
         m_milestone_mutex.unlock();
     }
     /**
@@ -142,6 +168,15 @@ public:
     void Stop()
     {
         m_milestone_mutex.lock();
+        Trace(CParcaeTraceEvent::END);
+        if (m_replay)
+        {
+            m_threads.SetNotReady();
+            m_milestone_mutex.unlock();
+            return;
+        }
+        if (m_round_failed)
+            m_failures.push_back(m_current_fate);
         m_current_fate->SetDeadEnd();
         m_current_fate->CheckDeadEnd();
         m_threads.SetNotReady();
@@ -150,8 +185,220 @@ public:
         //PARCAE_LOG("    GVIZ >>> \n%s\n", m_root->PrintDOT().c_str());
         m_milestone_mutex.unlock();
     }
+    /**
+     * @brief Fail - отметить текущий раунд как неудачный
+     * @remark Вызывается анализируемым кодом до Stop, если получен недопустимый результат
+     */
+    void Fail()
+    {
+        m_milestone_mutex.lock();
+        m_round_failed = true;
+        Trace(CParcaeTraceEvent::FAIL);
+        m_milestone_mutex.unlock();
+    }
+    /**
+     * @brief Read - отметить чтение разделяемых данных
+     * @param[in] thread_name - имя потока
+     * @param[in] address - адрес данных
+     * @param[in] site - место обращения
+     */
+    void Read(const std::string &thread_name, const void *address,
+              const std::source_location site = std::source_location::current())
+    {
+        m_milestone_mutex.lock();
+        m_races.Access(address, {thread_name, false, site});
+        m_shared_stages.insert(thread_name);
+        m_milestone_mutex.unlock();
+    }
+    /**
+     * @brief Write - отметить запись разделяемых данных
+     * @param[in] thread_name - имя потока
+     * @param[in] address - адрес данных
+     * @param[in] site - место обращения
+     */
+    void Write(const std::string &thread_name, const void *address,
+               const std::source_location site = std::source_location::current())
+    {
+        m_milestone_mutex.lock();
+        m_races.Access(address, {thread_name, true, site});
+        m_shared_stages.insert(thread_name);
+        m_milestone_mutex.unlock();
+    }
+    /**
+     * @brief Acquire - отметить захват объекта синхронизации (например, мьютекса)
+     * @param[in] thread_name - имя потока
+     * @param[in] sync - адрес объекта синхронизации
+     */
+    void Acquire(const std::string &thread_name, const void *sync)
+    {
+        m_milestone_mutex.lock();
+        m_races.Acquire(thread_name, sync);
+        m_shared_stages.insert(thread_name);
+        m_milestone_mutex.unlock();
+    }
+    /**
+     * @brief Release - отметить освобождение объекта синхронизации
+     * @param[in] thread_name - имя потока
+     * @param[in] sync - адрес объекта синхронизации
+     */
+    void Release(const std::string &thread_name, const void *sync)
+    {
+        m_milestone_mutex.lock();
+        m_races.Release(thread_name, sync);
+        m_shared_stages.insert(thread_name);
+        m_milestone_mutex.unlock();
+    }
+    /**
+     * @brief SetLocalInference - включить вывод локальности этапов из разметки обращений
+     * @param[in] inference - считать локальными этапы без размеченных обращений
+     * @remark Имеет смысл, только если размечены все обращения к разделяемым данным
+     */
+    void SetLocalInference(const bool inference) {m_local_inference = inference;}
+    /**
+     * @brief StartTrace - начать двоичную трассировку решений планировщика
+     * @param[in] path - путь к файлу трассировки
+     * @return удалось ли открыть файл
+     * @remark Записи фиксированного размера складываются в кольцевые буферы потоков и
+     * сбрасываются в файл фоновым потоком; файл читается CParcaeTraceReader. Имена потоков
+     * в заголовок берутся из Start при первом раунде после вызова.
+     */
+    bool StartTrace(const std::string &path)
+    {
+        return m_trace.Open(path);
+    }
+    /**
+     * @brief StopTrace - завершить трассировку, дописав все записи в файл
+     */
+    void StopTrace() {m_trace.Close();}
+    /**
+     * @brief BeginTasks - начать раунд задач-сопрограмм
+     * @param[in] task_names - имена задач
+     * @remark Для задач StartThread, Milestone и StopThread не блокируют поток, а только
+     * выбирают следующую задачу (см. NextTask). Используется CParcaeTaskRunner.
+     */
+    void BeginTasks(const std::vector<std::string> &task_names)
+    {
+        m_milestone_mutex.lock();
+        m_tasks = std::unordered_set<std::string>(task_names.cbegin(), task_names.cend());
+        m_task_next.clear();
+        m_milestone_mutex.unlock();
+    }
+    /**
+     * @brief NextTask - получить задачу, выбранную планировщиком для продолжения
+     * @return имя задачи или пустая строка, если продолжать некому
+     */
+    std::string NextTask() const
+    {
+        m_milestone_mutex.lock();
+        const std::string next = m_task_next;
+        m_milestone_mutex.unlock();
+        return next;
+    }
+    /**
+     * @brief EndTasks - завершить раунд задач-сопрограмм
+     */
+    void EndTasks()
+    {
+        m_milestone_mutex.lock();
+        m_tasks.clear();
+        m_task_next.clear();
+        m_milestone_mutex.unlock();
+    }
+    /**
+     * @brief Races - получить гонки данных, найденные с последнего вызова Start
+     * @return найденные гонки данных
+     */
+    const std::vector<CParcaeRace>& Races() const {return m_races.Races();}
+    /**
+     * @brief Failures - получить конечные узлы неудачных раундов
+     * @return конечные узлы дерева, для которых был вызван Fail
+     */
+    const std::vector<CParcaeNodePtr>& Failures() const {return m_failures;}
+    /**
+     * @brief Replay - выполнить один раунд по заданному расписанию
+     * @param[in] func - запускаемая функция (та же, что передаётся в Start)
+     * @param[in] schedule - расписание
+     * @return был ли раунд неудачным
+     * @remark Когда расписание исчерпано или указанный поток не готов, продолжается текущий поток
+     * (а если он завершился - первый готовый). Дерево выполнения не изменяется. Используются
+     * имена потоков из последнего вызова Start.
+     */
+    bool Replay(std::function<void()> func, const CParcaeSchedule &schedule)
+    {
+        CParcaeSchedule done;
+        return ReplayRound(func, schedule, done);
+    }
+    /**
+     * @brief Shrink - минимизировать неудачное расписание
+     * @param[in] func - запускаемая функция (та же, что передаётся в Start)
+     * @param[in] failure - конечный узел неудачного раунда
+     * @return неудачное расписание с наименьшим найденным числом вытеснений и длиной
+     */
+    CParcaeSchedule Shrink(std::function<void()> func, const CParcaeNodePtr &failure)
+    {
+        return Shrink(func, failure->Path());
+    }
+    /**
+     * @brief Shrink - минимизировать неудачное расписание
+     * @param[in] func - запускаемая функция (та же, что передаётся в Start)
+     * @param[in] failed - неудачное расписание
+     * @return неудачное расписание с наименьшим найденным числом вытеснений и длиной
+     * @remark Кандидаты (укороченные расписания и расписания с перенесённым вперёд шагом
+     * вытесненного потока) проверяются повторными раундами через Replay; каждый кандидат
+     * запускается не более одного раза. Если исходное расписание не воспроизводится, оно
+     * возвращается без изменений.
+     */
+    CParcaeSchedule Shrink(std::function<void()> func, const CParcaeSchedule &failed)
+    {
+        CParcaeSchedule done;
+        if (not ReplayRound(func, failed, done))
+            return failed;
+        CParcaeSchedule best = done.Prefix(failed.Size());
+        std::unordered_set<std::string> tried = {failed.Print(false)};
+        bool improved = true;
+        while (improved)
+        {
+            improved = false;
+            for (const auto &candidate : ShrinkCandidates(best))
+            {
+                if (not tried.insert(candidate.Print(false)).second)
+                    continue;
+                if (not ReplayRound(func, candidate, done))
+                    continue;
+                const auto witness = done.Prefix(candidate.Size());
+                if (witness.IsSimplerThan(best))
+                {
+                    PARCAE_LOG("SHRINK %s\n", witness.Print().c_str());
+                    best = witness;
+                    improved = true;
+                    break;
+                }
+            }
+        }
+        return best;
+    }
 
 private:
+    void Trace(const CParcaeTraceEvent event)
+    {
+        if (m_trace.IsOpen())
+            m_trace.Record(event, m_round);
+    }
+
+    void Trace(const CParcaeTraceEvent event, const std::string &thread_name)
+    {
+        if (m_trace.IsOpen())
+            m_trace.Record(event, m_round, m_threads.Index(thread_name));
+    }
+
+    void Trace(const CParcaeTraceEvent event, const std::string &thread_name, const uint milestone, const std::string &decision)
+    {
+        if (not m_trace.IsOpen())
+            return;
+        const uint16_t thread = m_threads.Index(thread_name);
+        m_trace.Record(event, m_round, thread, milestone, (decision == thread_name) ? thread : m_threads.Index(decision));
+    }
+
     std::string ChooseNextThread()
     {
         for (const auto &th_name : m_thread_names)
@@ -163,12 +410,155 @@ private:
         return "";
     }
 
+    std::string ChooseMilestoneThread(const std::string &thread_name, const uint num, const bool local)
+    {
+        m_races.Tick(thread_name);
+        const bool shared = (m_shared_stages.erase(thread_name) > 0);
+        if (local or (m_local_inference and not shared))
+        {
+            PARCAE_LOG("LOCAL MILESTONE %s:%u\n", thread_name.c_str(), num);
+            Trace(CParcaeTraceEvent::LOCAL, thread_name, num, thread_name);
+            return thread_name;
+        }
+        if (m_replay)
+        {
+            const auto new_thread = ReplayMilestone(thread_name, num);
+            Trace(CParcaeTraceEvent::MILESTONE, thread_name, num, new_thread);
+            return new_thread;
+        }
+        PARCAE_LOG("MILESTONE %s:%u # %s\n", thread_name.c_str(), num, m_current_fate->PrintPrevious().c_str());
+        std::string new_thread;
+        if (auto next_this = m_current_fate->FindNext(thread_name, num))
+        {
+            PARCAE_LOG("    FOUND\n");
+            std::string next_thread;
+            for (const auto &th_name : m_thread_names)
+            {
+                if (not m_threads.IsReady(th_name))
+                    continue;
+                if (auto next = next_this->FindNext(th_name))
+                    if (next->IsDeadEnd())
+                        continue;
+                next_thread = th_name;
+                break;
+            }
+            if (next_thread.empty())
+                printf("\n\n==== NO THREAD ====\n\n");
+            m_current_fate = next_this;
+            new_thread = next_thread;
+        }
+        else
+        {
+            PARCAE_LOG("    NOT FOUND\n");
+            for (const auto &th_name : m_thread_names)
+            {
+                if (not m_threads.IsReady(th_name))
+                    continue;
+                if (auto next = m_current_fate->FindNext(th_name))
+                {
+                    if (not next->IsDeadEnd())
+                    {
+                        m_current_fate = next;
+                        break;
+                    }
+                }
+                else
+                {
+                    MakeCurrent(thread_name, num);
+                    break;
+                }
+            }
+            new_thread = m_current_fate->ThreadName();
+        }
+        Trace(CParcaeTraceEvent::MILESTONE, thread_name, num, new_thread);
+        return new_thread;
+    }
+
+    std::string ReplayNextThread() const
+    {
+        const uint i = m_replay_done.Size();
+        if ((i < m_replay_schedule.Size()) and m_threads.IsReady(m_replay_schedule[i].thread_name))
+            return m_replay_schedule[i].thread_name;
+        return FirstReadyThread();
+    }
+
+    std::string FirstReadyThread() const
+    {
+        for (const auto &th_name : m_thread_names)
+        {
+            if (m_threads.IsReady(th_name))
+                return th_name;
+        }
+        return "";
+    }
+
+    std::string ReplayMilestone(const std::string &thread_name, const uint num)
+    {
+        m_replay_done.AddStep({thread_name, num, m_replay_preemption});
+        m_replay_preemption = false;
+        const uint i = m_replay_done.Size();
+        if ((i < m_replay_schedule.Size()) and m_threads.IsReady(m_replay_schedule[i].thread_name))
+        {
+            const auto &next_th = m_replay_schedule[i].thread_name;
+            m_replay_preemption = (next_th != thread_name);
+            return next_th;
+        }
+        return thread_name;
+    }
+
+    bool ReplayRound(std::function<void()> func, const CParcaeSchedule &schedule, CParcaeSchedule &done)
+    {
+        struct CReplayGuard
+        {
+            bool   &replay;
+            ~CReplayGuard() {replay = false;}
+        };
+        m_replay = true;
+        CReplayGuard guard{m_replay};
+        m_replay_schedule = schedule;
+        m_replay_done = CParcaeSchedule();
+        m_replay_preemption = false;
+        NewRound();
+        func();
+        done = m_replay_done;
+        return m_round_failed;
+    }
+
+    static std::vector<CParcaeSchedule> ShrinkCandidates(const CParcaeSchedule &best)
+    {
+        std::vector<CParcaeSchedule> candidates;
+        for (uint i = 0; i < best.Size(); ++i)
+            candidates.push_back(best.Prefix(i));
+        for (uint i = 1; i < best.Size(); ++i)
+        {
+            if (not best[i].preemption)
+                continue;
+            const auto &preempted = best[i-1].thread_name;
+            for (uint j = i + 1; j < best.Size(); ++j)
+            {
+                if (best[j].thread_name == preempted)
+                {
+                    candidates.push_back(best.MoveStep(j, i));
+                    break;
+                }
+            }
+        }
+        return candidates;
+    }
+
     void NewRound()
     {
         PARCAE_LOG("NEW ROUND\n");
-        for (const auto &th_name : m_thread_names)
+        ++m_round;
+        m_trace.Begin(m_thread_names);
+        Trace(CParcaeTraceEvent::ROUND);
+        m_round_failed = false;
+        m_races.Reset(m_thread_names);
+        m_shared_stages.clear();
+        for (size_t i = 0; i < m_thread_names.size(); ++i)
         {
-            m_threads.GetThread(th_name);
+            const auto &th_name = m_thread_names[i];
+            m_threads.GetThread(th_name).SetIndex(static_cast<uint16_t>(i));
             m_threads.Lock(th_name);
             m_threads.SetNotReady(th_name);
         }
@@ -197,8 +587,161 @@ private:
     std::vector<std::string>    m_thread_names;
     CParcaeNodePtr              m_root;
     CParcaeNodePtr              m_current_fate;
+    std::vector<CParcaeNodePtr> m_failures;
+    bool                        m_round_failed = false;
+    bool                        m_replay = false;
+    CParcaeSchedule             m_replay_schedule;
+    CParcaeSchedule             m_replay_done;
+    bool                        m_replay_preemption = false;
+    CParcaeRaceDetector         m_races;
+    std::unordered_set<std::string> m_shared_stages;
+    bool                        m_local_inference = false;
+    CParcaeTrace                m_trace;
+    std::unordered_set<std::string> m_tasks;
+    std::string                 m_task_next;
+    uint                        m_round = 0;
     mutable std::mutex          m_milestone_mutex;
 };
 using CParcaePtr = std::shared_ptr<CParcae>;
 
+/**
+ * @brief CParcaeShared - разделяемое значение с автоматической разметкой обращений
+ */
+template <typename T>
+class CParcaeShared
+{
+public:
+    /**
+     * @brief CParcaeShared - конструктор с явной параметризацией
+     * @param[in] parcae - анализатор, которому сообщается об обращениях
+     * @param[in] value - начальное значение
+     */
+    explicit CParcaeShared(CParcae &parcae, const T &value = T())
+        : m_parcae(parcae)
+        , m_value(value)
+    {
+
+    }
+    /**
+     * @brief Load - прочитать значение
+     * @param[in] thread_name - имя потока
+     * @param[in] site - место обращения
+     * @return значение
+     */
+    T Load(const std::string &thread_name, const std::source_location site = std::source_location::current()) const
+    {
+        m_parcae.Read(thread_name, &m_value, site);
+        return m_value;
+    }
+    /**
+     * @brief Store - записать значение
+     * @param[in] thread_name - имя потока
+     * @param[in] value - новое значение
+     * @param[in] site - место обращения
+     */
+    void Store(const std::string &thread_name, const T &value, const std::source_location site = std::source_location::current())
+    {
+        m_parcae.Write(thread_name, &m_value, site);
+        m_value = value;
+    }
+
+private:
+    CParcae    &m_parcae;
+    T           m_value;
+};
+
+/**
+ * @brief CParcaeTaskRunner - выполнение задач-сопрограмм как анализируемых потоков
+ * @remark Все задачи раунда выполняются в вызывающем потоке: на каждом этапе возобновляется
+ * ровно та задача, которую выбрал планировщик CParcae. StartThread и StopThread для задач
+ * вызываются автоматически, сами задачи вызывают только co_await Milestone(...) и не
+ * могут приостанавливаться на других ожидаемых объектах (Run выбросит std::logic_error).
+ * Смешивать в одном раунде задачи и обычные потоки нельзя.
+ */
+class CParcaeTaskRunner
+{
+public:
+    using TaskFactory = std::function<CParcaeTask()>;
+    /**
+     * @brief CParcaeTaskRunner - конструктор с явной параметризацией
+     * @param[in] parcae - анализатор
+     */
+    explicit CParcaeTaskRunner(CParcae &parcae)
+        : m_parcae(parcae)
+    {
+
+    }
+    /**
+     * @brief Add - зарегистрировать задачу
+     * @param[in] task_name - имя задачи (используется как имя потока)
+     * @param[in] factory - функция, создающая сопрограмму (вызывается в каждом раунде)
+     */
+    void Add(const std::string &task_name, TaskFactory factory)
+    {
+        m_names.push_back(task_name);
+        m_factories.push_back(factory);
+    }
+    /**
+     * @brief Names - получить имена задач
+     * @return имена задач (для передачи в CParcae::Start)
+     */
+    const std::vector<std::string>& Names() const {return m_names;}
+    /**
+     * @brief Run - выполнить один раунд всех задач
+     * @remark Вызывается из функции, передаваемой в CParcae::Start, вместо запуска потоков
+     */
+    void Run()
+    {
+        std::vector<CParcaeTask> tasks;
+        for (const auto &factory : m_factories)
+            tasks.push_back(factory());
+        m_parcae.BeginTasks(m_names);
+        CRoundGuard guard{m_parcae, m_names, std::vector<bool>(m_names.size(), false)};
+        for (const auto &task_name : m_names)
+            m_parcae.StartThread(task_name);
+        std::string current = m_parcae.NextTask();
+        while (not current.empty())
+        {
+            const auto it = std::find(m_names.cbegin(), m_names.cend(), current);
+            if (it == m_names.cend())
+                break;
+            const auto i = static_cast<size_t>(it - m_names.cbegin());
+            tasks[i].Resume();
+            if (tasks[i].Done())
+            {
+                guard.stopped[i] = true;
+                m_parcae.StopThread(current);
+            }
+            current = m_parcae.NextTask();
+        }
+    }
+
+private:
+    /**
+     * @brief CRoundGuard - завершение раунда задач при любом выходе из Run
+     * @remark Незавершённые задачи останавливаются через StopThread, иначе их мьютексы
+     * остались бы заблокированными и следующий раунд не смог бы начаться
+     */
+    struct CRoundGuard
+    {
+        CParcae                        &parcae;
+        const std::vector<std::string> &names;
+        std::vector<bool>               stopped;
+
+        ~CRoundGuard()
+        {
+            for (size_t i = 0; i < names.size(); ++i)
+            {
+                if (not stopped[i])
+                    parcae.StopThread(names[i]);
+            }
+            parcae.EndTasks();
+        }
+    };
+
+    CParcae                    &m_parcae;
+    std::vector<std::string>    m_names;
+    std::vector<TaskFactory>    m_factories;
+};
+
 #endif // PARCAE_H
@@ -0,0 +1,246 @@
+#ifndef RACE_H
+#define RACE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <optional>
+#include <algorithm>
+#include <source_location>
+#include <cstdio>
+
+#include "types.h"
+
+/**
+ * @brief CParcaeSite - место обращения к разделяемым данным
+ */
+struct CParcaeSite
+{
+    std::string             thread_name;        ///< имя потока
+    bool                    write = false;      ///< запись (иначе чтение)
+    std::source_location    location;           ///< место в исходном коде
+    /**
+     * @brief Print - получить строковое описание места обращения
+     * @return строковое описание места обращения
+     */
+    std::string Print() const
+    {
+        char s[512];
+        snprintf(s, sizeof(s), "%s %s %s:%u", write ? "write" : "read", thread_name.c_str(),
+                 location.file_name(), static_cast<uint>(location.line()));
+        return s;
+    }
+};
+
+/**
+ * @brief CParcaeRace - гонка данных (два неупорядоченных конфликтующих обращения)
+ */
+struct CParcaeRace
+{
+    const void     *address = nullptr;  ///< адрес разделяемых данных
+    CParcaeSite     first;              ///< предыдущее обращение
+    CParcaeSite     second;             ///< обращение, на котором обнаружена гонка
+    /**
+     * @brief Print - получить строковое описание гонки
+     * @return строковое описание гонки
+     */
+    std::string Print() const
+    {
+        char s[64];
+        snprintf(s, sizeof(s), "RACE %p: ", address);
+        return s + first.Print() + " <-> " + second.Print();
+    }
+};
+
+/**
+ * @brief CParcaeVectorClock - векторные часы
+ */
+class CParcaeVectorClock
+{
+public:
+    CParcaeVectorClock() = default;
+    /**
+     * @brief CParcaeVectorClock - конструктор с явной параметризацией
+     * @param[in] size - количество потоков
+     */
+    explicit CParcaeVectorClock(const size_t size)
+        : m_clock(size, 0)
+    {
+
+    }
+    /**
+     * @brief Get - получить значение компоненты
+     * @param[in] i - номер потока
+     * @return значение компоненты
+     */
+    uint Get(const size_t i) const {return (i < m_clock.size()) ? m_clock[i] : 0;}
+    /**
+     * @brief Tick - увеличить компоненту
+     * @param[in] i - номер потока
+     */
+    void Tick(const size_t i)
+    {
+        if (i < m_clock.size())
+            ++m_clock[i];
+    }
+    /**
+     * @brief Join - объединить с другими часами (покомпонентный максимум)
+     * @param[in] other - другие часы
+     */
+    void Join(const CParcaeVectorClock &other)
+    {
+        if (m_clock.size() < other.m_clock.size())
+            m_clock.resize(other.m_clock.size(), 0);
+        for (size_t i = 0; i < other.m_clock.size(); ++i)
+            m_clock[i] = std::max(m_clock[i], other.m_clock[i]);
+    }
+
+private:
+    std::vector<uint>   m_clock;
+};
+
+/**
+ * @brief CParcaeRaceDetector - детектор гонок данных на векторных часах
+ * @remark Учитываются только размеченные обращения (Read/Write) и синхронизация (Acquire/Release).
+ * Этапы не упорядочивают потоки между собой, поэтому гонка обнаруживается независимо от
+ * того, в каком порядке планировщик выполнил потоки в данном раунде.
+ */
+class CParcaeRaceDetector
+{
+public:
+    /**
+     * @brief Reset - подготовить детектор к новому раунду
+     * @param[in] thread_names - имена потоков
+     * @remark Найденные гонки сохраняются
+     */
+    void Reset(const std::vector<std::string> &thread_names)
+    {
+        m_index.clear();
+        m_clocks.clear();
+        for (size_t i = 0; i < thread_names.size(); ++i)
+        {
+            m_index.emplace(thread_names[i], i);
+            m_clocks.emplace_back(thread_names.size());
+            m_clocks.back().Tick(i);
+        }
+        m_sync.clear();
+        m_accesses.clear();
+    }
+    /**
+     * @brief Clear - очистить найденные гонки
+     */
+    void Clear()
+    {
+        m_races.clear();
+        m_reported.clear();
+    }
+    /**
+     * @brief Tick - начать новую эпоху потока
+     * @param[in] thread_name - имя потока
+     */
+    void Tick(const std::string &thread_name)
+    {
+        const auto th_it = m_index.find(thread_name);
+        if (th_it != m_index.end())
+            m_clocks[th_it->second].Tick(th_it->second);
+    }
+    /**
+     * @brief Acquire - захват объекта синхронизации
+     * @param[in] thread_name - имя потока
+     * @param[in] sync - адрес объекта синхронизации
+     */
+    void Acquire(const std::string &thread_name, const void *sync)
+    {
+        const auto th_it = m_index.find(thread_name);
+        const auto sync_it = m_sync.find(sync);
+        if ((th_it != m_index.end()) and (sync_it != m_sync.end()))
+            m_clocks[th_it->second].Join(sync_it->second);
+    }
+    /**
+     * @brief Release - освобождение объекта синхронизации
+     * @param[in] thread_name - имя потока
+     * @param[in] sync - адрес объекта синхронизации
+     */
+    void Release(const std::string &thread_name, const void *sync)
+    {
+        const auto th_it = m_index.find(thread_name);
+        if (th_it == m_index.end())
+            return;
+        m_sync[sync].Join(m_clocks[th_it->second]);
+        m_clocks[th_it->second].Tick(th_it->second);
+    }
+    /**
+     * @brief Access - обращение к разделяемым данным
+     * @param[in] address - адрес данных
+     * @param[in] site - место обращения
+     */
+    void Access(const void *address, const CParcaeSite &site)
+    {
+        const auto th_it = m_index.find(site.thread_name);
+        if (th_it == m_index.end())
+            return;
+        const size_t th = th_it->second;
+        const CParcaeVectorClock &clock = m_clocks[th];
+        auto &history = m_accesses[address];
+        if (history.write_epoch.has_value() and (history.write_thread != th) and
+                (*history.write_epoch > clock.Get(history.write_thread)))
+            Report(address, history.write_site, site);
+        if (site.write)
+        {
+            for (const auto &read : history.reads)
+            {
+                if ((read.first != th) and (read.second.epoch > clock.Get(read.first)))
+                    Report(address, read.second.site, site);
+            }
+            history.reads.clear();
+            history.write_thread = th;
+            history.write_epoch = clock.Get(th);
+            history.write_site = site;
+        }
+        else
+        {
+            history.reads[th] = {clock.Get(th), site};
+        }
+    }
+    /**
+     * @brief Races - получить найденные гонки
+     * @return найденные гонки (каждая пара мест - один раз, независимо от порядка обращений)
+     */
+    const std::vector<CParcaeRace>& Races() const {return m_races;}
+
+private:
+    void Report(const void *address, const CParcaeSite &first, const CParcaeSite &second)
+    {
+        const std::string first_str = first.Print();
+        const std::string second_str = second.Print();
+        const std::string key = std::min(first_str, second_str) + "|" + std::max(first_str, second_str);
+        if (not m_reported.insert(key).second)
+            return;
+        PARCAE_LOG("RACE %s <-> %s\n", first.Print().c_str(), second.Print().c_str());
+        m_races.push_back({address, first, second});
+    }
+
+    struct CRead
+    {
+        uint        epoch = 0;
+        CParcaeSite site;
+    };
+
+    struct CHistory
+    {
+        std::optional<uint>                 write_epoch;
+        size_t                              write_thread = 0;
+        CParcaeSite                         write_site;
+        std::unordered_map<size_t, CRead>   reads;
+    };
+
+    std::unordered_map<std::string, size_t>                 m_index;
+    std::vector<CParcaeVectorClock>                         m_clocks;
+    std::unordered_map<const void*, CParcaeVectorClock>     m_sync;
+    std::unordered_map<const void*, CHistory>               m_accesses;
+    std::vector<CParcaeRace>                                m_races;
+    std::unordered_set<std::string>                         m_reported;
+};
+
+#endif // RACE_H
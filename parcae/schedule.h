@@ -0,0 +1,138 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "types.h"
+
+/**
+ * @brief CParcaeStep - шаг расписания выполнения
+ */
+struct CParcaeStep
+{
+    std::string thread_name;            ///< имя потока, достигшего этапа
+    uint        milestone = 0;          ///< номер этапа
+    bool        preemption = false;     ///< переход к шагу вытеснил незавершённый поток
+};
+
+/**
+ * @brief CParcaeSchedule - расписание выполнения (последовательность этапов от корня дерева)
+ */
+class CParcaeSchedule
+{
+public:
+    CParcaeSchedule() = default;
+    /**
+     * @brief CParcaeSchedule - конструктор с явной параметризацией
+     * @param[in] steps - шаги расписания
+     */
+    explicit CParcaeSchedule(const std::vector<CParcaeStep> &steps)
+        : m_steps(steps)
+    {
+
+    }
+    /**
+     * @brief AddStep - добавить шаг в конец расписания
+     * @param[in] step - шаг
+     */
+    void AddStep(const CParcaeStep &step) {m_steps.push_back(step);}
+    /**
+     * @brief Steps - получить шаги расписания
+     * @return шаги расписания
+     */
+    const std::vector<CParcaeStep>& Steps() const {return m_steps;}
+    /**
+     * @brief Size - получить длину расписания
+     * @return количество шагов
+     */
+    uint Size() const {return static_cast<uint>(m_steps.size());}
+    /**
+     * @brief Empty - проверить расписание на пустоту
+     * @return пустое расписание или нет
+     */
+    bool Empty() const {return m_steps.empty();}
+    /**
+     * @brief operator[] - получить шаг по номеру
+     * @param[in] i - номер шага
+     * @return шаг
+     */
+    const CParcaeStep& operator[](const uint i) const {return m_steps[i];}
+    /**
+     * @brief Preemptions - получить количество вытеснений
+     * @return количество шагов, переход к которым вытеснил незавершённый поток
+     */
+    uint Preemptions() const
+    {
+        uint count = 0;
+        for (const auto &step : m_steps)
+        {
+            if (step.preemption)
+                ++count;
+        }
+        return count;
+    }
+    /**
+     * @brief IsSimplerThan - сравнить сложность расписаний
+     * @param[in] other - другое расписание
+     * @return меньше ли вытеснений (а при равенстве - шагов) в этом расписании
+     */
+    bool IsSimplerThan(const CParcaeSchedule &other) const
+    {
+        const uint preemptions = Preemptions();
+        const uint other_preemptions = other.Preemptions();
+        if (preemptions != other_preemptions)
+            return (preemptions < other_preemptions);
+        return (Size() < other.Size());
+    }
+    /**
+     * @brief Prefix - получить начало расписания
+     * @param[in] size - количество шагов
+     * @return первые size шагов расписания
+     */
+    CParcaeSchedule Prefix(const uint size) const
+    {
+        if (size >= Size())
+            return *this;
+        return CParcaeSchedule(std::vector<CParcaeStep>(m_steps.begin(), m_steps.begin() + size));
+    }
+    /**
+     * @brief MoveStep - получить расписание с переставленным шагом
+     * @param[in] from - номер переносимого шага
+     * @param[in] to - номер, на который переносится шаг (to < from)
+     * @return новое расписание
+     */
+    CParcaeSchedule MoveStep(const uint from, const uint to) const
+    {
+        std::vector<CParcaeStep> steps = m_steps;
+        if ((from < steps.size()) and (to < from))
+        {
+            const CParcaeStep step = steps[from];
+            steps.erase(steps.begin() + from);
+            steps.insert(steps.begin() + to, step);
+        }
+        return CParcaeSchedule(steps);
+    }
+    /**
+     * @brief Print - получить строковое представление расписания
+     * @param[in] preemptions - отмечать вытеснения звёздочкой
+     * @return строковое представление расписания
+     */
+    std::string Print(const bool preemptions = true) const
+    {
+        std::string str = "-ROOT";
+        for (const auto &step : m_steps)
+        {
+            char s[128];
+            snprintf(s, sizeof(s), "-%s%s:%u", (preemptions and step.preemption) ? "*" : "", step.thread_name.c_str(), step.milestone);
+            str += s;
+        }
+        return str;
+    }
+
+private:
+    std::vector<CParcaeStep>    m_steps;
+};
+
+#endif // SCHEDULE_H
@@ -0,0 +1,117 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief CParcaeTask - задача-сопрограмма, анализируемая как поток
+ * @remark Создаётся приостановленной; выполняется CParcaeTaskRunner. Задача может
+ * приостанавливаться только в co_await Milestone(...). CParcaeTask не является ожидаемым
+ * объектом, поэтому вложенные сопрограммы с этапами не поддерживаются.
+ */
+class CParcaeTask
+{
+public:
+    struct promise_type
+    {
+        CParcaeTask get_return_object() {return CParcaeTask(std::coroutine_handle<promise_type>::from_promise(*this));}
+        std::suspend_always initial_suspend() noexcept {return {};}
+        std::suspend_always final_suspend() noexcept {return {};}
+        void return_void() {}
+        void unhandled_exception() {m_exception = std::current_exception();}
+
+        std::exception_ptr  m_exception;
+        bool                m_milestone = false;    ///< последняя приостановка - на этапе
+    };
+
+    /**
+     * @brief CParcaeTask - конструктор с явной параметризацией
+     * @param[in] handle - дескриптор сопрограммы
+     */
+    explicit CParcaeTask(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+
+    }
+    CParcaeTask(CParcaeTask &&other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+
+    }
+    CParcaeTask& operator=(CParcaeTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    CParcaeTask(const CParcaeTask&) = delete;
+    CParcaeTask& operator=(const CParcaeTask&) = delete;
+    ~CParcaeTask()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+    /**
+     * @brief Resume - продолжить выполнение до следующего этапа
+     * @remark Исключение, вышедшее из сопрограммы, пробрасывается дальше. Если задача
+     * приостановилась не на co_await Milestone(...), выбрасывается std::logic_error.
+     */
+    void Resume()
+    {
+        if (Done())
+            return;
+        m_handle.promise().m_milestone = false;
+        m_handle.resume();
+        if (m_handle.promise().m_exception)
+            std::rethrow_exception(m_handle.promise().m_exception);
+        if ((not m_handle.done()) and (not m_handle.promise().m_milestone))
+            throw std::logic_error("parcae: task suspended outside co_await Milestone");
+    }
+    /**
+     * @brief Done - проверить завершение задачи
+     * @return завершена ли задача
+     */
+    bool Done() const {return ((not m_handle) or m_handle.done());}
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ * @brief CParcaeMilestone - ожидаемый объект, возвращаемый CParcae::Milestone
+ * @remark Для обычного потока ожидание не требуется (поток уже продолжил работу).
+ * Задача-сопрограмма приостанавливается, если планировщик выбрал другую задачу;
+ * приостановка отмечается в обещании задачи, чтобы CParcaeTask::Resume мог отличить её
+ * от приостановки на постороннем ожидаемом объекте.
+ */
+class CParcaeMilestone
+{
+public:
+    /**
+     * @brief CParcaeMilestone - конструктор с явной параметризацией
+     * @param[in] ready - можно ли продолжать без приостановки
+     */
+    explicit CParcaeMilestone(const bool ready)
+        : m_ready(ready)
+    {
+
+    }
+    bool await_ready() const noexcept {return m_ready;}
+    void await_suspend(std::coroutine_handle<CParcaeTask::promise_type> handle) const noexcept
+    {
+        handle.promise().m_milestone = true;
+    }
+    void await_resume() const noexcept {}
+
+private:
+    bool    m_ready = true;
+};
+
+#endif // TASK_H
@@ -0,0 +1,319 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+#include "types.h"
+
+/**
+ * @brief CParcaeTraceEvent - тип события трассировки
+ */
+enum class CParcaeTraceEvent : uint16_t
+{
+    ROUND = 0,      ///< начало раунда
+    START,          ///< запуск потока
+    MILESTONE,      ///< этап с выбором следующего потока
+    LOCAL,          ///< локальный этап (без ветвления)
+    STOP,           ///< завершение потока
+    FAIL,           ///< раунд отмечен как неудачный
+    END,            ///< завершение раунда
+};
+
+/**
+ * @brief CParcaeTraceRecord - запись трассировки фиксированного размера
+ */
+struct CParcaeTraceRecord
+{
+    static constexpr uint16_t NO_THREAD = CThread::NO_INDEX;    ///< поток не задан
+
+    uint64_t            timestamp = 0;              ///< время от начала трассировки, нс
+    uint32_t            round = 0;                  ///< номер раунда
+    uint32_t            milestone = 0;              ///< номер этапа
+    uint16_t            thread = NO_THREAD;         ///< номер потока
+    uint16_t            decision = NO_THREAD;       ///< номер потока, выбранного для продолжения
+    CParcaeTraceEvent   event = CParcaeTraceEvent::ROUND;   ///< тип события
+    uint16_t            reserved = 0;
+};
+static_assert(sizeof(CParcaeTraceRecord) == 24, "trace record must have fixed size");
+
+/**
+ * @brief CParcaeTraceRing - кольцевой буфер записей (один писатель, один читатель) без блокировок
+ * @remark Push не должен вызываться одновременно из нескольких потоков. Записи в буфер потока
+ * делает не только сам поток (например, START/STOP соседа), поэтому CParcae вызывает
+ * CParcaeTrace::Record только под m_milestone_mutex: мьютекс упорядочивает писателей, и для
+ * буфера они выглядят как один писатель.
+ */
+class CParcaeTraceRing
+{
+public:
+    static constexpr size_t CAPACITY = 1 << 14;     ///< ёмкость (степень двойки)
+    /**
+     * @brief Push - добавить запись
+     * @param[in] record - запись
+     * @return false, если буфер заполнен
+     */
+    bool Push(const CParcaeTraceRecord &record)
+    {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= CAPACITY)
+            return false;
+        m_records[head & (CAPACITY - 1)] = record;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    /**
+     * @brief Drain - записать накопленные записи в файл
+     * @param[in] file - файл
+     * @return количество записанных записей
+     */
+    size_t Drain(FILE *file)
+    {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        if (head == tail)
+            return 0;
+        const size_t begin = static_cast<size_t>(tail & (CAPACITY - 1));
+        const size_t count = static_cast<size_t>(head - tail);
+        const size_t first = std::min(count, CAPACITY - begin);
+        fwrite(&m_records[begin], sizeof(CParcaeTraceRecord), first, file);
+        fwrite(&m_records[0], sizeof(CParcaeTraceRecord), count - first, file);
+        m_tail.store(head, std::memory_order_release);
+        return count;
+    }
+
+private:
+    alignas(64) std::atomic<uint64_t>   m_head = 0;
+    alignas(64) std::atomic<uint64_t>   m_tail = 0;
+    std::vector<CParcaeTraceRecord>     m_records = std::vector<CParcaeTraceRecord>(CAPACITY);
+};
+
+/**
+ * @brief CParcaeTrace - двоичная трассировка с фоновой записью в файл
+ * @remark У каждого потока (и у управляющего потока) свой кольцевой буфер; фоновый поток
+ * периодически сбрасывает буферы в файл. Файл начинается с заголовка (сигнатура, версия,
+ * имена потоков), за которым следуют записи CParcaeTraceRecord.
+ */
+class CParcaeTrace
+{
+public:
+    static constexpr uint32_t MAGIC = 0x54435250;   ///< сигнатура "PRCT"
+    static constexpr uint32_t VERSION = 1;          ///< версия формата
+
+    ~CParcaeTrace() {Close();}
+    /**
+     * @brief Open - начать трассировку
+     * @param[in] path - путь к файлу
+     * @return удалось ли открыть файл
+     * @remark Заголовок записывается при первом вызове Begin
+     */
+    bool Open(const std::string &path)
+    {
+        Close();
+        m_file = fopen(path.c_str(), "wb");
+        return (m_file != nullptr);
+    }
+    /**
+     * @brief Begin - записать заголовок и запустить фоновую запись
+     * @param[in] thread_names - имена потоков
+     * @remark Повторные вызовы только проверяют, что имена потоков не изменились
+     */
+    void Begin(const std::vector<std::string> &thread_names)
+    {
+        if (not m_file)
+            return;
+        if (m_writer.joinable())
+        {
+            if ((thread_names != m_names) and (not m_names_differ))
+                printf("PARCAE TRACE: thread names differ from the trace header, events are recorded without thread\n");
+            m_names_differ = (thread_names != m_names);
+            return;
+        }
+        m_names = thread_names;
+        m_names_differ = false;
+        WriteU32(MAGIC);
+        WriteU32(VERSION);
+        WriteU32(static_cast<uint32_t>(thread_names.size()));
+        m_rings.clear();
+        for (const auto &name : thread_names)
+        {
+            WriteU32(static_cast<uint32_t>(name.size()));
+            fwrite(name.data(), 1, name.size(), m_file);
+        }
+        for (size_t i = 0; i <= thread_names.size(); ++i)
+            m_rings.emplace_back(new CParcaeTraceRing());
+        m_start = std::chrono::steady_clock::now();
+        m_running = true;
+        m_writer = std::thread(&CParcaeTrace::Write, this);
+    }
+    /**
+     * @brief Close - завершить трассировку, сбросив все записи в файл
+     */
+    void Close()
+    {
+        if (not m_file)
+            return;
+        if (m_writer.joinable())
+        {
+            m_running = false;
+            m_writer.join();
+        }
+        fclose(m_file);
+        m_file = nullptr;
+    }
+    /**
+     * @brief IsOpen - проверить, ведётся ли трассировка
+     * @return ведётся ли трассировка (файл открыт и заголовок записан)
+     */
+    bool IsOpen() const {return ((m_file != nullptr) and m_writer.joinable());}
+    /**
+     * @brief Record - добавить событие
+     * @param[in] event - тип события
+     * @param[in] round - номер раунда
+     * @param[in] thread - номер потока в заголовке (NO_THREAD - управляющий поток)
+     * @param[in] milestone - номер этапа
+     * @param[in] decision - номер потока, выбранного для продолжения
+     * @remark Номера потоков разрешаются вызывающим заранее, поэтому запись не работает со
+     * строками. Вызовы должны быть упорядочены внешней блокировкой (см. CParcaeTraceRing).
+     * Если буфер потока заполнен, писатель ждёт, пока фоновый поток его освободит.
+     */
+    void Record(const CParcaeTraceEvent event, const uint round, const uint16_t thread = CParcaeTraceRecord::NO_THREAD,
+                const uint milestone = 0, const uint16_t decision = CParcaeTraceRecord::NO_THREAD)
+    {
+        const size_t threads = m_rings.size() - 1;
+        CParcaeTraceRecord record;
+        record.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                      std::chrono::steady_clock::now() - m_start).count());
+        record.round = round;
+        record.milestone = milestone;
+        if (not m_names_differ)
+        {
+            record.thread = (thread < threads) ? thread : CParcaeTraceRecord::NO_THREAD;
+            record.decision = (decision < threads) ? decision : CParcaeTraceRecord::NO_THREAD;
+        }
+        record.event = event;
+        const size_t ring = (record.thread == CParcaeTraceRecord::NO_THREAD) ? threads : record.thread;
+        while (not m_rings[ring]->Push(record))
+            std::this_thread::yield();
+    }
+
+private:
+    void WriteU32(const uint32_t value)
+    {
+        fwrite(&value, sizeof(value), 1, m_file);
+    }
+
+    void Write()
+    {
+        while (m_running)
+        {
+            size_t count = 0;
+            for (auto &ring : m_rings)
+                count += ring->Drain(m_file);
+            if (count == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (auto &ring : m_rings)
+            ring->Drain(m_file);
+    }
+
+    FILE                                               *m_file = nullptr;
+    std::vector<std::string>                            m_names;
+    bool                                                m_names_differ = false;
+    std::vector<std::unique_ptr<CParcaeTraceRing>>      m_rings;
+    std::chrono::steady_clock::time_point               m_start;
+    std::atomic<bool>                                   m_running = false;
+    std::thread                                         m_writer;
+};
+
+/**
+ * @brief CParcaeTraceReader - чтение файла трассировки
+ */
+class CParcaeTraceReader
+{
+public:
+    /**
+     * @brief Read - прочитать файл трассировки
+     * @param[in] path - путь к файлу
+     * @return удалось ли прочитать файл
+     * @remark Записи упорядочиваются по времени
+     */
+    bool Read(const std::string &path)
+    {
+        m_names.clear();
+        m_records.clear();
+        FILE *file = fopen(path.c_str(), "rb");
+        if (not file)
+            return false;
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint32_t count = 0;
+        bool ok = ReadU32(file, magic) and (magic == CParcaeTrace::MAGIC) and
+                  ReadU32(file, version) and (version == CParcaeTrace::VERSION) and
+                  ReadU32(file, count);
+        for (uint32_t i = 0; ok and (i < count); ++i)
+        {
+            uint32_t size = 0;
+            ok = ReadU32(file, size);
+            std::string name(size, '\0');
+            ok = ok and (fread(name.data(), 1, size, file) == size);
+            m_names.push_back(name);
+        }
+        CParcaeTraceRecord record;
+        while (ok and (fread(&record, sizeof(record), 1, file) == 1))
+            m_records.push_back(record);
+        fclose(file);
+        std::stable_sort(m_records.begin(), m_records.end(),
+                         [](const CParcaeTraceRecord &a, const CParcaeTraceRecord &b) { return a.timestamp < b.timestamp; });
+        return ok;
+    }
+    /**
+     * @brief Names - получить имена потоков
+     * @return имена потоков
+     */
+    const std::vector<std::string>& Names() const {return m_names;}
+    /**
+     * @brief Records - получить записи
+     * @return записи, упорядоченные по времени
+     */
+    const std::vector<CParcaeTraceRecord>& Records() const {return m_records;}
+    /**
+     * @brief Print - получить строковое описание записи
+     * @param[in] record - запись
+     * @return строковое описание записи
+     */
+    std::string Print(const CParcaeTraceRecord &record) const
+    {
+        static const char *events[] = {"ROUND", "START", "MILESTONE", "LOCAL", "STOP", "FAIL", "END"};
+        const auto event = static_cast<size_t>(record.event);
+        char s[256];
+        snprintf(s, sizeof(s), "%12.3f us round %u %-9s %s:%u -> %s",
+                 static_cast<double>(record.timestamp) / 1000.0, record.round,
+                 (event < sizeof(events)/sizeof(events[0])) ? events[event] : "?",
+                 Name(record.thread).c_str(), record.milestone, Name(record.decision).c_str());
+        return s;
+    }
+
+private:
+    std::string Name(const uint16_t thread) const
+    {
+        return (thread < m_names.size()) ? m_names[thread] : "-";
+    }
+
+    static bool ReadU32(FILE *file, uint32_t &value)
+    {
+        return (fread(&value, sizeof(value), 1, file) == 1);
+    }
+
+    std::vector<std::string>            m_names;
+    std::vector<CParcaeTraceRecord>     m_records;
+};
+
+#endif // TRACE_H
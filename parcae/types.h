@@ -1,6 +1,14 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
 #undef PARCAE_LOG
 //#define PARCAE_LOG(...) printf(__VA_ARGS__)
 #define PARCAE_LOG(...) {}
@@ -13,6 +21,8 @@ using uint = unsigned int;
 class CThread
 {
 public:
+    static constexpr uint16_t NO_INDEX = 0xFFFF;    ///< номер потока не задан
+
     /**
      * @brief CThread - конструктор с явной параметризацией
      * @param[in] name - имя потока
@@ -36,8 +46,8 @@ public:
      */
     void Unlock() const
     {
-        m_thread_mutex.unlock();
         m_running = true;
+        m_thread_mutex.unlock();
     }
     /**
      * @brief IsRunning - предикат выполнения
@@ -47,6 +57,12 @@ public:
     {
         return m_running;
     }
+    /**
+     * @brief SetRunning - установить признак выполнения
+     * @param[in] running - выполняется поток или нет
+     * @remark Позволяет пометить поток как остановленный ещё до фактической блокировки
+     */
+    void SetRunning(const bool running) const {m_running = running;}
     /**
      * @brief SetReady - установить готовность потока к работе
      * @param[in] ready - готовность потока к работе
@@ -62,11 +78,22 @@ public:
      * @return имя потока
      */
     std::string Name() const {return m_name;}
+    /**
+     * @brief SetIndex - установить номер потока
+     * @param[in] index - номер потока в списке имён, переданном в CParcae::Start
+     */
+    void SetIndex(const uint16_t index) {m_index = index;}
+    /**
+     * @brief Index - получить номер потока
+     * @return номер потока или NO_INDEX
+     */
+    uint16_t Index() const {return m_index;}
 
 private:
     bool                m_ready = false;
+    uint16_t            m_index = NO_INDEX;
     std::string         m_name;
-    mutable bool        m_running = true;
+    mutable std::atomic<bool> m_running = true;
     mutable std::mutex  m_thread_mutex;
 };
 
@@ -139,6 +166,20 @@ public:
         }
         return false;
     }
+    /**
+     * @brief Index - получить номер потока по имени
+     * @param[in] thread_name - имя потока
+     * @return номер потока или CThread::NO_INDEX
+     */
+    uint16_t Index(const std::string &thread_name) const
+    {
+        auto th_it = m_threads.find(thread_name);
+        if (th_it != m_threads.end())
+        {
+            return th_it->second.Index();
+        }
+        return CThread::NO_INDEX;
+    }
     /**
      * @brief Clear - очистить список потоков
      */